@@ -5,7 +5,12 @@
 #include <QPixmap>
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QPointer>
+#include <QList>
 #include <QMatrix4x4>
+#include <QtMath>
 #include <QVector3D>
 #include <QWheelEvent>
 #include <QMouseEvent>
@@ -21,13 +26,34 @@
 #include <QDoubleSpinBox>
 #include <QDialogButtonBox>
 #include <QPainter>
+#include <QStatusBar>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QTimer>
 #include <iostream>
 #include <vector>
 #include <QString>
-#include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <array>
+#include <functional>
+#include <cstring> // For std::memcmp
 #include <limits> // For std::numeric_limits
+#include <cstddef> // For offsetof
 #include <GL/glu.h> // For gluProject
+#if defined(__SSE2__)
+#include <emmintrin.h> // 統計パスのSIMD化
+#endif
 
 #include "happly.h"
 
@@ -96,6 +122,440 @@ struct Point {
     unsigned int u, v; // u, v座標を追加
 };
 
+// 点群の統計情報 (バウンディングボックス・重心・奥行きヒストグラム・色範囲)
+// 読み込み時の変換ループの中で、チャンク単位に1回の走査で集計する。
+struct CloudStats {
+    static constexpr int kDepthBins = 64;
+    static constexpr double kMinDepth = 0.01;    // ヒストグラムの下限 (対数ビン)
+    static constexpr double kMaxDepth = 10000.0; // ヒストグラムの上限 (対数ビン)
+
+    size_t count = 0;
+    double minPos[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    double maxPos[3] = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+    double sumPos[3] = {0, 0, 0};
+    unsigned char minColor[3] = {255, 255, 255};
+    unsigned char maxColor[3] = {0, 0, 0};
+    std::array<size_t, kDepthBins> depthHistogram{};
+
+    bool isValid() const { return count > 0; }
+    QVector3D minPoint() const { return QVector3D(minPos[0], minPos[1], minPos[2]); }
+    QVector3D maxPoint() const { return QVector3D(maxPos[0], maxPos[1], maxPos[2]); }
+    QVector3D centroid() const {
+        return count ? QVector3D(sumPos[0] / count, sumPos[1] / count, sumPos[2] / count) : QVector3D();
+    }
+
+    // 重心を中心とし、バウンディングボックス全体を含む球の半径
+    float boundingRadius() const {
+        if (!count) return 0.0f;
+        const QVector3D c = centroid();
+        float radius = 0.0f;
+        for (int corner = 0; corner < 8; ++corner) {
+            QVector3D p((corner & 1) ? maxPos[0] : minPos[0], (corner & 2) ? maxPos[1] : minPos[1], (corner & 4) ? maxPos[2] : minPos[2]);
+            radius = std::max(radius, c.distanceToPoint(p));
+        }
+        return radius;
+    }
+
+    // 奥行き(z)の対数ビン番号。範囲外は両端のビンに入れる。
+    // 対数は計算せず、指数部と仮数部から求めた近似ビンをビン境界との比較で補正する。
+    static int depthBin(double z) {
+        return correctDepthBin(z, approxDepthBin(z));
+    }
+
+    // ビンの境界 (kDepthBins + 1個)。edges[b] <= z < edges[b + 1] ならビンb。
+    static const std::array<double, kDepthBins + 1>& depthEdges() {
+        static const std::array<double, kDepthBins + 1> edges = []() {
+            std::array<double, kDepthBins + 1> e{};
+            for (int bin = 0; bin <= kDepthBins; ++bin) {
+                e[bin] = kMinDepth * std::pow(kMaxDepth / kMinDepth, static_cast<double>(bin) / kDepthBins);
+            }
+            e[kDepthBins] = kMaxDepth;
+            return e;
+        }();
+        return edges;
+    }
+
+    // log2(z) = 指数部 + log2(仮数部) の第2項を2次式で近似し (誤差0.005)、ビン番号に換算する。
+    // 誤差は1ビン未満なので、correctDepthBinで正しいビンに直せる。
+    static constexpr double kLog2Coeff[3] = {-1.67487759, 2.02466578, -0.34484843};
+    static constexpr double kLog2MinDepth = -6.643856189774724;  // log2(kMinDepth)
+    static constexpr double kBinsPerOctave = 3.2109866204157993; // kDepthBins / log2(kMaxDepth / kMinDepth)
+
+    static int approxDepthBin(double z) {
+        uint64_t bits;
+        std::memcpy(&bits, &z, sizeof(bits));
+        const double exponent = static_cast<double>(static_cast<int>((bits >> 52) & 0x7ff) - 1023);
+        bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+        double mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+        const double log2z = exponent + (kLog2Coeff[2] * mantissa + kLog2Coeff[1]) * mantissa + kLog2Coeff[0];
+        return static_cast<int>((log2z - kLog2MinDepth) * kBinsPerOctave);
+    }
+
+    static int correctDepthBin(double z, int bin) {
+        if (!(z > kMinDepth)) return 0;
+        if (z >= kMaxDepth) return kDepthBins - 1;
+        const auto& edges = depthEdges();
+        bin = std::min(std::max(bin, 0), kDepthBins - 1);
+        while (bin > 0 && z < edges[bin]) --bin;
+        while (bin < kDepthBins - 1 && z >= edges[bin + 1]) ++bin;
+        return bin;
+    }
+
+    static double depthBinCenter(int bin) {
+        const double ratio = kMaxDepth / kMinDepth;
+        return kMinDepth * std::pow(ratio, (bin + 0.5) / kDepthBins);
+    }
+
+    // ヒストグラムから奥行きの分位点(0〜1)を求める (ビン中央値の精度)
+    double depthPercentile(double q) const {
+        const double target = q * count;
+        double cumulative = 0.0;
+        for (int bin = 0; bin < kDepthBins; ++bin) {
+            cumulative += depthHistogram[bin];
+            if (cumulative >= target && depthHistogram[bin] > 0) return depthBinCenter(bin);
+        }
+        return depthBinCenter(kDepthBins - 1);
+    }
+
+    void merge(const CloudStats& other) {
+        count += other.count;
+        for (int a = 0; a < 3; ++a) {
+            minPos[a] = std::min(minPos[a], other.minPos[a]);
+            maxPos[a] = std::max(maxPos[a], other.maxPos[a]);
+            sumPos[a] += other.sumPos[a];
+            minColor[a] = std::min(minColor[a], other.minColor[a]);
+            maxColor[a] = std::max(maxColor[a], other.maxColor[a]);
+        }
+        for (int bin = 0; bin < kDepthBins; ++bin) {
+            depthHistogram[bin] += other.depthHistogram[bin];
+        }
+    }
+
+    // 範囲[begin, end)の点を集計する。色配列がnullptrなら白(255)として扱う。
+    // 座標の最小・最大・総和、奥行きの近似ビン、色の最小・最大はSSE2でベクトル化する。
+    void accumulate(const double* x, const double* y, const double* z,
+                    const unsigned char* r, const unsigned char* g, const unsigned char* b,
+                    size_t begin, size_t end) {
+        if (begin >= end) return;
+        count += end - begin;
+
+        const double* pos[3] = {x, y, z};
+        size_t i = begin;
+#if defined(__SSE2__)
+        __m128d minV[3], maxV[3], sumV[3];
+        for (int a = 0; a < 3; ++a) {
+            minV[a] = _mm_set1_pd(minPos[a]);
+            maxV[a] = _mm_set1_pd(maxPos[a]);
+            sumV[a] = _mm_setzero_pd();
+        }
+        const __m128i exponentMask = _mm_set1_epi64x(0x7ff);
+        const __m128d mantissaMask = _mm_castsi128_pd(_mm_set1_epi64x(0x000fffffffffffffLL));
+        const __m128d one = _mm_set1_pd(1.0);
+        alignas(16) int approxBin[4];
+        for (; i + 2 <= end; i += 2) {
+            for (int a = 0; a < 3; ++a) {
+                const __m128d v = _mm_loadu_pd(pos[a] + i);
+                minV[a] = _mm_min_pd(minV[a], v);
+                maxV[a] = _mm_max_pd(maxV[a], v);
+                sumV[a] = _mm_add_pd(sumV[a], v);
+            }
+            // approxDepthBinを2点まとめて計算する。補正とヒストグラムへの加算は点ごとに行う。
+            const __m128d zv = _mm_loadu_pd(z + i);
+            const __m128i exponentBits = _mm_and_si128(_mm_srli_epi64(_mm_castpd_si128(zv), 52), exponentMask);
+            const __m128d exponent = _mm_sub_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(exponentBits, _MM_SHUFFLE(2, 0, 2, 0))),
+                                                _mm_set1_pd(1023.0));
+            const __m128d mantissa = _mm_or_pd(_mm_and_pd(zv, mantissaMask), one);
+            __m128d log2z = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(kLog2Coeff[2]), mantissa), _mm_set1_pd(kLog2Coeff[1]));
+            log2z = _mm_add_pd(_mm_mul_pd(log2z, mantissa), _mm_set1_pd(kLog2Coeff[0]));
+            log2z = _mm_add_pd(log2z, exponent);
+            const __m128d binV = _mm_mul_pd(_mm_sub_pd(log2z, _mm_set1_pd(kLog2MinDepth)), _mm_set1_pd(kBinsPerOctave));
+            _mm_store_si128(reinterpret_cast<__m128i*>(approxBin), _mm_cvttpd_epi32(binV));
+            ++depthHistogram[correctDepthBin(z[i], approxBin[0])];
+            ++depthHistogram[correctDepthBin(z[i + 1], approxBin[1])];
+        }
+        for (int a = 0; a < 3; ++a) {
+            double lo[2], hi[2], sum[2];
+            _mm_storeu_pd(lo, minV[a]);
+            _mm_storeu_pd(hi, maxV[a]);
+            _mm_storeu_pd(sum, sumV[a]);
+            minPos[a] = std::min(lo[0], lo[1]);
+            maxPos[a] = std::max(hi[0], hi[1]);
+            sumPos[a] += sum[0] + sum[1];
+        }
+#endif
+        for (; i < end; ++i) {
+            for (int a = 0; a < 3; ++a) {
+                minPos[a] = std::min(minPos[a], pos[a][i]);
+                maxPos[a] = std::max(maxPos[a], pos[a][i]);
+                sumPos[a] += pos[a][i];
+            }
+            ++depthHistogram[depthBin(z[i])];
+        }
+
+        if (!r || !g || !b) {
+            for (int a = 0; a < 3; ++a) {
+                maxColor[a] = 255; // 最小値は初期値の255のまま
+            }
+            return;
+        }
+        const unsigned char* color[3] = {r, g, b};
+        i = begin;
+#if defined(__SSE2__)
+        __m128i minC[3], maxC[3];
+        for (int a = 0; a < 3; ++a) {
+            minC[a] = _mm_set1_epi8(static_cast<char>(minColor[a]));
+            maxC[a] = _mm_set1_epi8(static_cast<char>(maxColor[a]));
+        }
+        for (; i + 16 <= end; i += 16) {
+            for (int a = 0; a < 3; ++a) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(color[a] + i));
+                minC[a] = _mm_min_epu8(minC[a], v);
+                maxC[a] = _mm_max_epu8(maxC[a], v);
+            }
+        }
+        for (int a = 0; a < 3; ++a) {
+            alignas(16) unsigned char lo[16], hi[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lo), minC[a]);
+            _mm_store_si128(reinterpret_cast<__m128i*>(hi), maxC[a]);
+            minColor[a] = *std::min_element(lo, lo + 16);
+            maxColor[a] = *std::max_element(hi, hi + 16);
+        }
+#endif
+        for (; i < end; ++i) {
+            for (int a = 0; a < 3; ++a) {
+                minColor[a] = std::min(minColor[a], color[a][i]);
+                maxColor[a] = std::max(maxColor[a], color[a][i]);
+            }
+        }
+    }
+};
+
+// 3次元kd-木 (k近傍探索用)
+// 座標配列は参照で保持するため、木より長く生存させること。
+// 構築後は読み取り専用なので、複数スレッドから同時に探索できる。
+// cancelが立つと構築を途中で打ち切る (打ち切った木は探索に使わないこと)。
+class KdTree
+{
+public:
+    struct Neighbor {
+        float distSq;
+        uint32_t index;
+        bool operator<(const Neighbor& other) const { return distSq < other.distSq; }
+    };
+
+    explicit KdTree(const std::vector<QVector3D>& positions, const std::atomic<bool>* cancel = nullptr)
+        : pts(positions), cancel(cancel) {
+        order.resize(pts.size());
+        std::iota(order.begin(), order.end(), 0u);
+        axes.assign(pts.size(), 0);
+        build(0, order.size());
+    }
+
+    // queryに最も近いk点を距離の昇順でoutに格納する (query自身が点群に含まれていればそれも返す)
+    void knn(const QVector3D& query, size_t k, std::vector<Neighbor>& out) const {
+        knn(query, k, out, [](uint32_t) { return false; });
+    }
+
+    // skip(index)が真の点を除いてk近傍を求める。木の形は変えないので、構築後に位置が変わった点を
+    // 除外して別に探索する用途に使える。
+    template <typename Skip>
+    void knn(const QVector3D& query, size_t k, std::vector<Neighbor>& out, const Skip& skip) const {
+        out.clear();
+        if (k == 0 || order.empty()) return;
+        search(0, order.size(), query, k, out, skip); // outは探索中、最大ヒープとして使う
+        std::sort_heap(out.begin(), out.end());
+    }
+
+private:
+    // 範囲[lo, hi)の中央値で分割する。分割軸は範囲の広がりが最大の軸。
+    void build(size_t lo, size_t hi) {
+        if (hi - lo <= 1) return;
+        if (cancel && cancel->load(std::memory_order_relaxed)) return;
+        QVector3D minP(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+        QVector3D maxP = -minP;
+        for (size_t i = lo; i < hi; ++i) {
+            const QVector3D& p = pts[order[i]];
+            for (int a = 0; a < 3; ++a) {
+                minP[a] = std::min(minP[a], p[a]);
+                maxP[a] = std::max(maxP[a], p[a]);
+            }
+        }
+        QVector3D extent = maxP - minP;
+        uint8_t axis = 0;
+        if (extent.y() > extent[axis]) axis = 1;
+        if (extent.z() > extent[axis]) axis = 2;
+
+        size_t mid = lo + (hi - lo) / 2;
+        std::nth_element(order.begin() + lo, order.begin() + mid, order.begin() + hi,
+                         [this, axis](uint32_t a, uint32_t b) { return pts[a][axis] < pts[b][axis]; });
+        axes[mid] = axis;
+        build(lo, mid);
+        build(mid + 1, hi);
+    }
+
+    template <typename Skip>
+    void search(size_t lo, size_t hi, const QVector3D& query, size_t k, std::vector<Neighbor>& heap, const Skip& skip) const {
+        if (lo >= hi) return;
+        size_t mid = lo + (hi - lo) / 2;
+        uint32_t idx = order[mid];
+        float distSq = (pts[idx] - query).lengthSquared();
+        if (skip(idx)) {
+            // 候補にはしないが、分割面としては使う
+        } else if (heap.size() < k) {
+            heap.push_back({distSq, idx});
+            std::push_heap(heap.begin(), heap.end());
+        } else if (distSq < heap.front().distSq) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = {distSq, idx};
+            std::push_heap(heap.begin(), heap.end());
+        }
+        if (hi - lo == 1) return;
+
+        // クエリ側の部分木から探索し、分割面までの距離が現在のk番目より近ければ反対側も探索する
+        uint8_t axis = axes[mid];
+        float diff = query[axis] - pts[idx][axis];
+        if (diff < 0) {
+            search(lo, mid, query, k, heap, skip);
+            if (heap.size() < k || diff * diff < heap.front().distSq) search(mid + 1, hi, query, k, heap, skip);
+        } else {
+            search(mid + 1, hi, query, k, heap, skip);
+            if (heap.size() < k || diff * diff < heap.front().distSq) search(lo, mid, query, k, heap, skip);
+        }
+    }
+
+    const std::vector<QVector3D>& pts;
+    const std::atomic<bool>* cancel;
+    std::vector<uint32_t> order; // 暗黙的な木: 範囲の中央要素がノード
+    std::vector<uint8_t> axes;   // 各ノードの分割軸
+};
+
+// 近傍点の共分散行列をPCAで解析し、最小固有値に対応する固有ベクトルを法線として返す
+// 対称3x3行列の固有値分解にはヤコビ法を用いる。近傍点が3点未満なら失敗。
+static bool estimateNormalPca(const std::vector<QVector3D>& neighbors, QVector3D& normal)
+{
+    if (neighbors.size() < 3) return false;
+
+    double mean[3] = {0, 0, 0};
+    for (const auto& p : neighbors) {
+        for (int a = 0; a < 3; ++a) mean[a] += p[a];
+    }
+    for (int a = 0; a < 3; ++a) mean[a] /= neighbors.size();
+
+    double cov[3][3] = {};
+    for (const auto& p : neighbors) {
+        double d[3];
+        for (int a = 0; a < 3; ++a) d[a] = p[a] - mean[a];
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) cov[r][c] += d[r] * d[c];
+        }
+    }
+
+    double vec[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    for (int sweep = 0; sweep < 16; ++sweep) {
+        double off = cov[0][1] * cov[0][1] + cov[0][2] * cov[0][2] + cov[1][2] * cov[1][2];
+        double diag = cov[0][0] * cov[0][0] + cov[1][1] * cov[1][1] + cov[2][2] * cov[2][2];
+        if (off <= 1e-24 * diag) break;
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (std::abs(cov[p][q]) < 1e-300) continue;
+                double theta = (cov[q][q] - cov[p][p]) / (2.0 * cov[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0);
+                double s = t * c;
+                for (int k = 0; k < 3; ++k) {
+                    double akp = cov[k][p], akq = cov[k][q];
+                    cov[k][p] = c * akp - s * akq;
+                    cov[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    double apk = cov[p][k], aqk = cov[q][k];
+                    cov[p][k] = c * apk - s * aqk;
+                    cov[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    double vkp = vec[k][p], vkq = vec[k][q];
+                    vec[k][p] = c * vkp - s * vkq;
+                    vec[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    // 固有値を昇順に並べる。全点が重複 (トレース0) や一直線上 (2番目の固有値が0) の近傍では
+    // 平面が定まらないので失敗とする。
+    int order[3] = {0, 1, 2};
+    std::sort(order, order + 3, [&cov](int a, int b) { return cov[a][a] < cov[b][b]; });
+    const double trace = cov[0][0] + cov[1][1] + cov[2][2];
+    if (!(trace > 0.0) || cov[order[1]][order[1]] <= 1e-6 * trace) return false;
+
+    const int minAxis = order[0];
+    normal = QVector3D(vec[0][minAxis], vec[1][minAxis], vec[2][minAxis]).normalized();
+    return !normal.isNull();
+}
+
+// 法線推定用の近傍探索インデックス (座標のスナップショットとそのkd-木)
+// 構築は点群全体に比例するので、再読み込みをまたいで使い回す。
+struct NormalIndex {
+    NormalIndex(std::vector<QVector3D>&& snapshot, const std::atomic<bool>* cancel)
+        : positions(std::move(snapshot)), tree(positions, cancel) {}
+
+    const std::vector<QVector3D> positions;
+    const KdTree tree; // positionsを参照するので、positionsより後に宣言する
+};
+
+// 構築済みのNormalIndexに、構築後に位置が変わった点 (変更・追加・入れ替え) を重ねて探索する
+// 変更点は元の木の候補から外し、変更点だけで作った小さなkd-木を別に探索して結果をまとめる。
+// 準備にかかる時間は変更点の数に比例する。
+class PatchedNeighborSearch
+{
+public:
+    PatchedNeighborSearch(std::shared_ptr<const NormalIndex> index, std::vector<uint32_t> indices,
+                          std::vector<QVector3D> positions, size_t size)
+        : base(std::move(index)), staleIndices(std::move(indices)), stalePositions(std::move(positions)),
+          staleTree(stalePositions), count(size) {
+        staleSlot.reserve(staleIndices.size());
+        for (size_t j = 0; j < staleIndices.size(); ++j) {
+            staleSlot.emplace(staleIndices[j], static_cast<uint32_t>(j));
+        }
+    }
+
+    size_t size() const { return count; }
+
+    // 現在の点群でのi番目の点の位置
+    QVector3D position(uint32_t i) const {
+        if (!staleSlot.empty()) {
+            auto it = staleSlot.find(i);
+            if (it != staleSlot.end()) return stalePositions[it->second];
+        }
+        return base->positions[i];
+    }
+
+    // 現在の点群でのk近傍。scratchは呼び出し側が使い回す作業領域。
+    void knn(const QVector3D& query, size_t k, std::vector<KdTree::Neighbor>& out,
+             std::vector<KdTree::Neighbor>& scratch) const {
+        if (staleSlot.empty() && count == base->positions.size()) {
+            base->tree.knn(query, k, out);
+            return;
+        }
+        base->tree.knn(query, k, out, [this](uint32_t i) { return i >= count || staleSlot.count(i) != 0; });
+        staleTree.knn(query, k, scratch);
+        for (const auto& n : scratch) {
+            out.push_back({n.distSq, staleIndices[n.index]});
+        }
+        std::sort(out.begin(), out.end());
+        if (out.size() > k) out.resize(k);
+    }
+
+private:
+    std::shared_ptr<const NormalIndex> base;
+    std::vector<uint32_t> staleIndices;
+    std::vector<QVector3D> stalePositions;
+    KdTree staleTree; // stalePositionsを参照する
+    size_t count;
+    std::unordered_map<uint32_t, uint32_t> staleSlot; // 点のインデックス -> stale配列での位置
+};
+
 // クリックイベントを処理するカスタム画像ラベル
 class ImageLabel : public QLabel
 {
@@ -247,72 +707,185 @@ signals:
 };
 
 
-// 点群を描画するOpenGLウィジェット
-class PointCloudWidget : public QOpenGLWidget, protected QOpenGLFunctions
+// 複数のビューで共有される点群データ
+// 点群本体・UVインデックス・選択点・VBOを1つだけ持ち、各PointCloudWidgetはこれを参照して描画する。
+// VBOは共有OpenGLコンテキストグループ上に作成されるため、どのビューのコンテキストからでも利用できる。
+class PointCloudData : public QObject
 {
     Q_OBJECT
 
 public:
-    PointCloudWidget(QWidget *parent = nullptr) : QOpenGLWidget(parent) {}
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr size_t kNormalNeighbors = 16;  // 法線推定に使う近傍点数
+    // 変更点の近傍として推定し直す点数。k近傍は対称でない (点群の縁などでは、変更点をk近傍に含む点が
+    // 変更点のk近傍に入らない) ので、推定に使う点数より広めに取る。
+    static constexpr size_t kExpandNeighbors = 2 * kNormalNeighbors;
+    static constexpr size_t kNormalBlockSize = 4096; // 法線推定の並列処理・逐次反映の単位
+    static constexpr size_t kLoadChunkSize = 2048;   // 読み込み時の統計集計・変換の単位
+    static constexpr size_t kParallelLoadThreshold = 65536; // これ未満の点数なら単一スレッドで変換する
+    static constexpr size_t kIndexRebuildFraction = 8; // 点群の1/8を超える点が変わったら法線推定のkd-木を作り直す
+
+    explicit PointCloudData(QObject *parent = nullptr) : QObject(parent) {
+        // 書き込み途中のファイルを読まないよう、変更通知が落ち着いてから再読み込みする
+        reloadTimer.setSingleShot(true);
+        reloadTimer.setInterval(300);
+        connect(&reloadTimer, &QTimer::timeout, this, [this]() { reloadPly(); });
+        connect(&fileWatcher, &QFileSystemWatcher::fileChanged, this, [this]() {
+            updateWatchedPath(); // 置き換え保存で監視が外れることがあるため付け直す
+            reloadTimer.start();
+        });
+        connect(&fileWatcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+            // 削除されていたファイルが作り直されたら、監視を付け直して読み直す
+            if (!fileWatcher.files().contains(sourcePath) && QFileInfo::exists(sourcePath)) {
+                updateWatchedPath();
+                reloadTimer.start();
+            }
+        });
+    }
 
-    void setInitialCameraState(const QVector3D& pos, const QVector3D& center, const QVector3D& up) {
-        initialCameraPosition = pos;
-        initialViewCenter = center;
-        initialUpVector = up;
+    ~PointCloudData() override {
+        cancelReload();
+        flushNormalCache();
+        cancelNormalEstimation();
     }
 
     // PLYファイルから点群をロードする
-    void loadPly(const std::string& filepath) {
+    bool loadPly(const std::string& filepath) {
+        std::vector<Point> loaded;
+        bool hasUV = false;
+        CloudStats loadedStats;
+        const SourceStamp stamp = SourceStamp::of(QString::fromStdString(filepath));
         try {
-            happly::PLYData plyIn(filepath);
-            std::vector<double> x = plyIn.getElement("vertex").getProperty<double>("x");
-            std::vector<double> y = plyIn.getElement("vertex").getProperty<double>("y");
-            std::vector<double> z = plyIn.getElement("vertex").getProperty<double>("z");
-            std::vector<unsigned char> r, g, b;
-            bool hasColor = false;
-            try {
-                r = plyIn.getElement("vertex").getProperty<unsigned char>("red");
-                g = plyIn.getElement("vertex").getProperty<unsigned char>("green");
-                b = plyIn.getElement("vertex").getProperty<unsigned char>("blue");
-                hasColor = true;
-            } catch (const std::exception&) {}
-            std::vector<unsigned int> u, v;
-            bool hasUV = false;
-            try {
-                u = plyIn.getElement("vertex").getProperty<unsigned int>("u");
-                v = plyIn.getElement("vertex").getProperty<unsigned int>("v");
-                hasUV = true;
-            } catch (const std::exception&) {}
-
-            points.clear();
-            uv_map.clear();
-            for (size_t i = 0; i < x.size(); ++i) {
-                Point p;
-                p.x = static_cast<float>(x[i]);
-                p.y = static_cast<float>(y[i]);
-                p.z = static_cast<float>(z[i]);
-                p.r = hasColor ? r[i] : 255;
-                p.g = hasColor ? g[i] : 255;
-                p.b = hasColor ? b[i] : 255;
-                if (hasUV) {
-                    p.u = u[i];
-                    p.v = v[i];
-                    uv_map[{p.u, p.v}] = i;
-                } else {
-                    p.u = 0;
-                    p.v = 0;
-                }
-                points.push_back(p);
-            }
-            update();
+            readPlyVertices(filepath, loaded, hasUV, loadedStats);
         } catch (const std::exception& e) {
             std::cerr << "Error loading PLY file: " << e.what() << std::endl;
+            return false;
+        }
+
+        // 実行中の再読み込みは点群を読んでいるので、置き換える前に止める
+        cancelReload();
+        flushNormalCache(); // 前の点群で再推定した法線を保存しておく
+        sourcePath = QString::fromStdString(filepath);
+        sourceStamp = stamp;
+        updateWatchedPath();
+        replaceCloud(loaded, hasUV, loadedStats, false);
+        return true;
+    }
+
+    // 監視中のPLYを読み直し、(u, v)をキーに現在の点群との差分を点群・UVインデックス・VBOへ反映する
+    // 選択点は(u, v)で引き継ぎ、カメラには触れない。
+    // (u, v)を持たない点群や、新しいファイルに同じ(u, v)が重複している場合は、読み込んだ点で全体を置き換える。
+    //
+    // パースと差分の計算 (点群全体に比例) はワーカースレッドで行い、GUIスレッドでは変更点だけを反映する。
+    // ワーカーは点群とUVインデックスを読むので、その間GUIスレッドはこれらを書き換えない
+    // (反映はワーカーの終了後、全体の読み込みはcancelReloadの後に行う)。
+    // 読み込み中に次の変更通知が来た場合は、反映の後にもう一度読み直す。
+    void reloadPly() {
+        if (sourcePath.isEmpty()) return;
+        if (reloadThread.joinable()) {
+            reloadQueued = true;
+            return;
         }
+        updateWatchedPath();
+        const QString path = sourcePath;
+        const bool diffable = !uv_map.empty();
+        const quint64 generation = reloadGeneration;
+        reloadThread = std::thread([this, path, diffable, generation]() {
+            auto result = std::make_shared<ReloadResult>();
+            computeReload(path, diffable, *result);
+            QMetaObject::invokeMethod(this, [this, generation, result]() {
+                applyReload(generation, *result);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    // 読み込んだPLYの変更を監視し、変更があれば差分を再読み込みする
+    void setWatchEnabled(bool enabled) {
+        watchEnabled = enabled;
+        updateWatchedPath();
+    }
+
+    const std::vector<Point>& getPoints() const { return points; }
+    const CloudStats& getStats() const { return stats; }
+    size_t size() const { return points.size(); }
+    bool isEmpty() const { return points.empty(); }
+
+    // 選択中の点 (未選択ならnullptr)
+    const Point* selectedPoint() const {
+        return selectedIndex < points.size() ? &points[selectedIndex] : nullptr;
+    }
+
+    // 共有VBOをカレントコンテキストにバインドする。点群が変更されていれば再転送する。
+    // 呼び出し側のOpenGLコンテキストがカレントであること。
+    bool bindVertexBuffer() {
+        if (points.empty()) return false;
+        if (!vertexBuffer.isCreated()) {
+            if (!vertexBuffer.create()) return false;
+            vertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+            gpuDirty = true;
+        }
+        vertexBuffer.bind();
+        if (gpuDirty) {
+            vertexBuffer.allocate(points.data(), static_cast<int>(points.size() * sizeof(Point)));
+            vertexBufferCapacity = points.size();
+            gpuDirty = false;
+        } else {
+            for (const auto& range : vertexDirtyRanges) {
+                // 後の再読み込みで縮小した場合は、残っている部分だけを転送する
+                if (range.first >= points.size()) continue;
+                const size_t length = std::min(range.second, points.size() - range.first);
+                vertexBuffer.write(static_cast<int>(range.first * sizeof(Point)), &points[range.first],
+                                   static_cast<int>(length * sizeof(Point)));
+            }
+        }
+        vertexDirtyRanges.clear();
+        return true;
+    }
+
+    void releaseVertexBuffer() {
+        vertexBuffer.release();
+    }
+
+    // 法線VBOをバインドする。推定済み・変更された法線があれば差分だけ転送する。
+    bool bindNormalBuffer() {
+        if (normals.empty() || normals.size() != points.size()) return false;
+        if (!normalBuffer.isCreated()) {
+            if (!normalBuffer.create()) return false;
+            normalBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+            normalGpuDirty = true;
+        }
+        normalBuffer.bind();
+        if (normalGpuDirty) {
+            normalBuffer.allocate(normals.data(), static_cast<int>(normals.size() * sizeof(QVector3D)));
+            normalBufferCapacity = normals.size();
+            normalGpuDirty = false;
+        } else {
+            for (const auto& range : normalDirtyRanges) {
+                if (range.first >= normals.size()) continue;
+                const size_t length = std::min(range.second, normals.size() - range.first);
+                normalBuffer.write(static_cast<int>(range.first * sizeof(QVector3D)), &normals[range.first],
+                                   static_cast<int>(length * sizeof(QVector3D)));
+            }
+        }
+        normalDirtyRanges.clear();
+        return true;
+    }
+
+    void releaseNormalBuffer() {
+        normalBuffer.release();
+    }
+
+    // GPUリソースを破棄する。残ったビューは次回描画時に再作成する。
+    void destroyGpuResources() {
+        vertexBuffer.destroy();
+        normalBuffer.destroy();
+        gpuDirty = true;
+        normalGpuDirty = true;
     }
 
 public slots:
-    void findAndHighlightPoint(int u, int v) {
-        size_t point_idx = -1;
+    void selectPixel(int u, int v) {
+        size_t point_idx = npos;
         bool exact_match = false;
 
         // 1. 高速な完全一致を試みる
@@ -339,12 +912,8 @@ public slots:
         }
 
         // 3. 点が見つかった場合（完全一致または最近傍）
-        if (point_idx != -1) {
+        if (point_idx != npos) {
             const auto& foundPoint = points[point_idx];
-            lineTargetPoint = QVector3D(foundPoint.x, foundPoint.y, foundPoint.z);
-            lineStartPoint = initialCameraPosition; // 原点
-            lineDistance = lineStartPoint.distanceToPoint(lineTargetPoint);
-            isLineActive = true;
             if (exact_match) {
                  std::cout << "Point found at (" << u << ", " << v << ")." << std::endl;
             } else {
@@ -353,19 +922,799 @@ public slots:
         }
         // 4. 点群が空の場合
         else {
-            isLineActive = false;
             std::cout << "No points loaded to search." << std::endl;
         }
-        emit lineDistanceCalculated(isLineActive ? lineDistance : -1.0f);
+        selectedIndex = point_idx;
+        emit selectionChanged();
+    }
+
+signals:
+    void cloudChanged();
+    void selectionChanged();
+    void cloudReloaded(size_t modified, size_t added, size_t removed);
+    void normalsUpdated();
+    void normalsProgress(size_t done, size_t total);
+
+private:
+    // 読み込んだ時点の元ファイルのサイズと更新日時。読み込み前に取得するので、
+    // 読み込み中に書き換えられた場合はキャッシュの照合に失敗する側に倒れる。
+    struct SourceStamp {
+        qint64 size = -1;
+        qint64 modified = 0;
+
+        static SourceStamp of(const QString& path) {
+            QFileInfo info(path);
+            SourceStamp stamp;
+            if (info.exists()) {
+                stamp.size = info.size();
+                stamp.modified = info.lastModified().toMSecsSinceEpoch();
+            }
+            return stamp;
+        }
+    };
+
+    struct UVHash {
+        size_t operator()(const std::pair<unsigned int, unsigned int>& key) const {
+            return std::hash<quint64>()((static_cast<quint64>(key.first) << 32) | key.second);
+        }
+    };
+
+    // 視点(ステレオカメラ原点)を向く仮の法線。推定が終わるまでの陰影表示に使う。
+    static QVector3D provisionalNormal(const QVector3D& p) {
+        return p.isNull() ? QVector3D(0, 0, -1) : (-p).normalized();
+    }
+
+    // 読み込んだ点で点群全体を置き換え、UVインデックスとGPUバッファを作り直す
+    // keepSelectionなら選択点を(u, v)で引き継ぐ。
+    void replaceCloud(std::vector<Point>& loaded, bool hasUV, const CloudStats& loadedStats, bool keepSelection) {
+        const bool hadSelection = keepSelection && hasUV && selectedIndex < points.size();
+        const std::pair<unsigned int, unsigned int> selectedUV =
+            hadSelection ? std::make_pair(points[selectedIndex].u, points[selectedIndex].v) : std::make_pair(0u, 0u);
+
+        cancelNormalEstimation();
+        ++normalGeneration; // 実行中・反映待ちのジョブの結果を捨てる
+        points.swap(loaded);
+        stats = loadedStats;
+        uv_map.clear();
+        if (hasUV) {
+            uv_map.reserve(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                uv_map[{points[i].u, points[i].v}] = i;
+            }
+        }
+        selectedIndex = npos;
+        if (hadSelection) {
+            auto it = uv_map.find(selectedUV);
+            if (it != uv_map.end()) selectedIndex = it->second;
+        }
+        gpuDirty = true;
+        vertexDirtyRanges.clear();
+
+        // 法線: キャッシュがあれば使い、なければ仮法線で表示しつつバックグラウンドで推定する
+        normalIndex.reset();
+        indexStale.clear();
+        normalPending.clear();
+        normalSeeds.clear();
+        normalCacheDirty = false;
+        if (!loadNormalCache()) {
+            normals.resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                normals[i] = provisionalNormal(QVector3D(points[i].x, points[i].y, points[i].z));
+            }
+            startNormalEstimation(true);
+        }
+        normalGpuDirty = true;
+        normalDirtyRanges.clear();
+
+        emit cloudChanged();
+        emit selectionChanged();
+    }
+
+    // 再読み込みの結果。ワーカースレッドで作り、GUIスレッドで反映する。
+    struct ReloadResult {
+        bool ok = false;
+        SourceStamp stamp;
+        CloudStats stats;
+        bool hasUV = false;
+        bool fullReplace = false; // 差分を取れないので、incomingで全体を置き換える
+        std::vector<Point> incoming;
+        std::vector<std::pair<uint32_t, Point>> modified; // (現在のインデックス, 新しい値)
+        std::vector<Point> added;
+        std::vector<uint32_t> removed; // 降順
+    };
+
+    // ワーカースレッドで実行される。PLYを読み、現在の点群との差分を(u, v)で求める。
+    // 点群とUVインデックスは読むだけで、GUIスレッドはこの間これらを書き換えない。
+    void computeReload(const QString& path, bool diffable, ReloadResult& result) const {
+        const std::string filepath = path.toStdString();
+        result.stamp = SourceStamp::of(path);
+        try {
+            readPlyVertices(filepath, result.incoming, result.hasUV, result.stats);
+        } catch (const std::exception& e) {
+            std::cerr << "Error reloading PLY file: " << e.what() << std::endl;
+            return;
+        }
+        result.ok = true;
+        if (!result.hasUV || !diffable) {
+            result.fullReplace = true;
+            return;
+        }
+
+        std::vector<char> seen(points.size(), 0);
+        std::unordered_set<std::pair<unsigned int, unsigned int>, UVHash> addedKeys;
+        for (const Point& q : result.incoming) {
+            if (reloadCancel) return;
+            const std::pair<unsigned int, unsigned int> key(q.u, q.v);
+            auto it = uv_map.find(key);
+            const bool duplicate = it != uv_map.end() ? seen[it->second] != 0 : !addedKeys.insert(key).second;
+            if (duplicate) {
+                // 新しいファイル内で(u, v)が重複している: 画素をキーにした差分は取れないので全体を置き換える
+                std::cout << "Duplicate (u, v) in " << filepath << "; replacing the whole cloud." << std::endl;
+                result.fullReplace = true;
+                result.modified.clear();
+                result.added.clear();
+                return;
+            }
+            if (it != uv_map.end()) {
+                const size_t i = it->second;
+                seen[i] = 1;
+                if (!samePoint(points[i], q)) result.modified.emplace_back(static_cast<uint32_t>(i), q);
+            } else {
+                result.added.push_back(q);
+            }
+        }
+        for (size_t i = points.size(); i-- > 0;) {
+            if (!seen[i]) result.removed.push_back(static_cast<uint32_t>(i));
+        }
+        result.incoming.clear();
+        result.incoming.shrink_to_fit();
+    }
+
+    // GUIスレッドで再読み込みの結果を反映する。差分の反映にかかる時間は変更点の数に比例する。
+    void applyReload(quint64 generation, ReloadResult& result) {
+        if (generation != reloadGeneration) return; // 全体の読み込みで無効になった結果
+        if (reloadThread.joinable()) reloadThread.join();
+
+        if (result.ok && result.fullReplace) {
+            sourceStamp = result.stamp;
+            replaceCloud(result.incoming, result.hasUV, result.stats, true);
+            emit cloudReloaded(points.size(), 0, 0); // 全点を変更として扱う
+        } else if (result.ok) {
+            applyReloadDiff(result);
+        }
+
+        if (reloadQueued) {
+            reloadQueued = false;
+            reloadPly();
+        }
+    }
+
+    void applyReloadDiff(const ReloadResult& result) {
+        sourceStamp = result.stamp;
+        stats = result.stats; // 重複が無いので、差分適用後の点群は新しいファイルの点群と一致する
+
+        const bool hadSelection = selectedIndex < points.size();
+        const std::pair<unsigned int, unsigned int> selectedUV =
+            hadSelection ? std::make_pair(points[selectedIndex].u, points[selectedIndex].v) : std::make_pair(0u, 0u);
+
+        std::vector<uint32_t> changed;
+        changed.reserve(result.modified.size() + result.added.size() + result.removed.size());
+        for (const auto& m : result.modified) {
+            normalSeeds.emplace_back(points[m.first].x, points[m.first].y, points[m.first].z);
+            points[m.first] = m.second;
+            changed.push_back(m.first);
+        }
+        for (const Point& q : result.added) {
+            uv_map[{q.u, q.v}] = points.size();
+            changed.push_back(static_cast<uint32_t>(points.size()));
+            points.push_back(q);
+            normals.emplace_back();
+        }
+
+        // 新しいファイルに無い点は末尾の点と入れ替えて削除する
+        // 降順に処理するので、入れ替え元の末尾は常に残す点になる
+        for (uint32_t i : result.removed) {
+            const size_t last = points.size() - 1;
+            normalSeeds.emplace_back(points[i].x, points[i].y, points[i].z);
+            // 前回の全体読み込みで重複していた点は、uv_mapが別の(残す)点を指しているので消さない
+            auto it = uv_map.find({points[i].u, points[i].v});
+            if (it != uv_map.end() && it->second == i) {
+                uv_map.erase(it);
+            }
+            if (i != last) {
+                points[i] = points[last];
+                normals[i] = normals[last];
+                uv_map[{points[i].u, points[i].v}] = i;
+                changed.push_back(i);
+            }
+            points.pop_back();
+            normals.pop_back();
+        }
+
+        changed.erase(std::remove_if(changed.begin(), changed.end(),
+                                     [this](uint32_t i) { return i >= points.size(); }),
+                      changed.end());
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+        for (uint32_t i : changed) {
+            normals[i] = provisionalNormal(QVector3D(points[i].x, points[i].y, points[i].z));
+            normalPending.insert(i);
+            indexStale.insert(i);
+        }
+
+        // GPUへは変更された点だけを転送する
+        markDirty(changed, vertexDirtyRanges, gpuDirty, vertexBufferCapacity);
+        markDirty(changed, normalDirtyRanges, normalGpuDirty, normalBufferCapacity);
+
+        if (hadSelection) {
+            auto it = uv_map.find(selectedUV);
+            selectedIndex = it != uv_map.end() ? it->second : npos;
+        }
+
+        std::cout << "Reloaded " << sourcePath.toStdString() << ": " << result.modified.size() << " modified, "
+                  << result.added.size() << " added, " << result.removed.size() << " removed." << std::endl;
+        // 実行中の推定は止めずに最後まで進め、終わったところで変更点を推定し直す
+        if ((!changed.empty() || !normalSeeds.empty()) && !normalJobRunning) startNormalEstimation(false);
+
+        emit cloudChanged();
+        emit selectionChanged();
+        emit cloudReloaded(result.modified.size(), result.added.size(), result.removed.size());
+    }
+
+    void cancelReload() {
+        ++reloadGeneration; // 反映待ちの結果を捨てる
+        reloadQueued = false;
+        if (reloadThread.joinable()) {
+            reloadCancel = true;
+            reloadThread.join();
+        }
+        reloadCancel = false;
+    }
+
+    static bool samePoint(const Point& a, const Point& b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.r == b.r && a.g == b.g && a.b == b.b;
+    }
+
+    // PLYファイルの頂点を読み込み、同じ走査で統計情報を集計する。読み込みに失敗した場合は例外を送出する。
+    // 変換はスレッドごとの連続区間に分けて並列に行い、各区間はキャッシュに収まるチャンク単位で
+    // 統計の集計と点への変換を続けて処理する。
+    static void readPlyVertices(const std::string& filepath, std::vector<Point>& out, bool& hasUV, CloudStats& stats) {
+        happly::PLYData plyIn(filepath);
+        std::vector<double> x = plyIn.getElement("vertex").getProperty<double>("x");
+        std::vector<double> y = plyIn.getElement("vertex").getProperty<double>("y");
+        std::vector<double> z = plyIn.getElement("vertex").getProperty<double>("z");
+        std::vector<unsigned char> r, g, b;
+        bool hasColor = false;
+        try {
+            r = plyIn.getElement("vertex").getProperty<unsigned char>("red");
+            g = plyIn.getElement("vertex").getProperty<unsigned char>("green");
+            b = plyIn.getElement("vertex").getProperty<unsigned char>("blue");
+            hasColor = true;
+        } catch (const std::exception&) {}
+        std::vector<unsigned int> u, v;
+        hasUV = false;
+        try {
+            u = plyIn.getElement("vertex").getProperty<unsigned int>("u");
+            v = plyIn.getElement("vertex").getProperty<unsigned int>("v");
+            hasUV = true;
+        } catch (const std::exception&) {}
+
+        const size_t count = x.size();
+        out.clear();
+        out.resize(count);
+        const unsigned threadCount = count >= kParallelLoadThreshold ? std::max(1u, std::thread::hardware_concurrency()) : 1u;
+        std::vector<CloudStats> partial(threadCount);
+
+        auto convertRange = [&](unsigned t) {
+            const size_t begin = count * t / threadCount;
+            const size_t end = count * (t + 1) / threadCount;
+            for (size_t chunk = begin; chunk < end; chunk += kLoadChunkSize) {
+                const size_t chunkEnd = std::min(end, chunk + kLoadChunkSize);
+                partial[t].accumulate(x.data(), y.data(), z.data(),
+                                      hasColor ? r.data() : nullptr, hasColor ? g.data() : nullptr, hasColor ? b.data() : nullptr,
+                                      chunk, chunkEnd);
+                for (size_t i = chunk; i < chunkEnd; ++i) {
+                    Point& p = out[i];
+                    p.x = static_cast<float>(x[i]);
+                    p.y = static_cast<float>(y[i]);
+                    p.z = static_cast<float>(z[i]);
+                    p.r = hasColor ? r[i] : 255;
+                    p.g = hasColor ? g[i] : 255;
+                    p.b = hasColor ? b[i] : 255;
+                    p.u = hasUV ? u[i] : 0;
+                    p.v = hasUV ? v[i] : 0;
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threadCount; ++t) {
+            workers.emplace_back(convertRange, t);
+        }
+        convertRange(0);
+        for (auto& t : workers) {
+            t.join();
+        }
+
+        stats = CloudStats();
+        for (const auto& s : partial) {
+            stats.merge(s);
+        }
+    }
+
+    // 変更された点のインデックスを連続区間 (開始, 個数) にまとめ、GPU未転送の範囲に加える
+    // バッファ容量を超える場合や区間が多すぎる場合は全体の再転送に切り替える
+    void markDirty(const std::vector<uint32_t>& sortedIndices, std::vector<std::pair<size_t, size_t>>& ranges,
+                   bool& fullUpload, size_t capacity) const {
+        if (fullUpload) return;
+        if (points.size() > capacity || sortedIndices.size() * 4 > points.size()) {
+            fullUpload = true;
+            ranges.clear();
+            return;
+        }
+        for (size_t i = 0; i < sortedIndices.size();) {
+            size_t j = i + 1;
+            while (j < sortedIndices.size() && sortedIndices[j] == sortedIndices[j - 1] + 1) ++j;
+            ranges.emplace_back(sortedIndices[i], j - i);
+            i = j;
+        }
+        if (ranges.size() > 4096) {
+            fullUpload = true;
+            ranges.clear();
+        }
+    }
+
+    // 法線推定ジョブの入力。GUIスレッドで作り、ワーカースレッドに渡す。
+    struct NormalJob {
+        std::vector<uint32_t> targets;
+        bool expandNeighbors = false; // 対象とseedsの近傍点の法線も更新する
+        std::vector<QVector3D> seeds;
+        size_t size = 0;              // 開始時の点数
+        std::shared_ptr<const NormalIndex> index; // 使い回すインデックス (nullならsnapshotから作る)
+        std::vector<QVector3D> snapshot;          // インデックスを作り直す場合の全点の座標
+        std::vector<uint32_t> staleIndices;       // indexの構築後に位置が変わった点とその現在の座標
+        std::vector<QVector3D> stalePositions;
+    };
+
+    // 法線推定ジョブを開始する。allなら全点、そうでなければ再読み込みで変わった点(normalPending)と、
+    // その変更前後の位置の近傍点が対象。近傍探索のkd-木は前のジョブのものを使い回し、構築後に位置が変わった点が
+    // 点群の1/kIndexRebuildFractionを超えた場合だけ作り直す。使い回す場合にワーカーへ渡すのは
+    // 変わった点の座標だけなので、準備にかかる時間は変更点の数に比例する。
+    void startNormalEstimation(bool all) {
+        if (points.empty()) return;
+        auto job = std::make_shared<NormalJob>();
+        if (all) {
+            job->targets.resize(points.size());
+            std::iota(job->targets.begin(), job->targets.end(), 0u);
+        } else {
+            for (uint32_t i : normalPending) {
+                if (i < points.size()) job->targets.push_back(i);
+            }
+            std::sort(job->targets.begin(), job->targets.end());
+        }
+        normalPending.clear();
+        job->seeds.swap(normalSeeds);
+        normalSeeds.clear();
+        if (job->targets.empty() && job->seeds.empty()) return;
+        job->expandNeighbors = !all;
+        job->size = points.size();
+
+        if (all || !normalIndex || indexStale.size() * kIndexRebuildFraction > points.size()) {
+            job->snapshot.reserve(points.size());
+            for (const auto& p : points) {
+                job->snapshot.emplace_back(p.x, p.y, p.z);
+            }
+            normalIndex.reset();
+            indexStale.clear(); // 以後に変わった点は、このジョブが作るインデックスに対して記録する
+        } else {
+            job->index = normalIndex;
+            for (uint32_t i : indexStale) {
+                if (i >= points.size()) continue;
+                job->staleIndices.push_back(i);
+                job->stalePositions.emplace_back(points[i].x, points[i].y, points[i].z);
+            }
+        }
+
+        if (normalThread.joinable()) normalThread.join();
+        normalsDone = 0;
+        normalsTotal = job->targets.size();
+        normalJobRunning = true;
+        const quint64 generation = normalGeneration;
+        normalThread = std::thread([this, job, all, generation]() {
+            runNormalEstimation(*job, all, generation);
+        });
+        emit normalsProgress(0, normalsTotal);
+    }
+
+    void cancelNormalEstimation() {
+        if (normalThread.joinable()) {
+            normalCancel = true;
+            normalThread.join();
+        }
+        normalCancel = false;
+        normalJobRunning = false;
+    }
+
+    // ワーカースレッドで実行される。必要ならkd-木を構築し、ブロック単位で並列にk近傍探索とPCAを行う。
+    // 結果はブロックごとにGUIスレッドへ送り、逐次反映する。
+    // 近傍点の更新が必要な場合は、対象点の推定と同じ並列処理の中で広めの近傍を集め、
+    // 続けて集めた点を並列に推定する。
+    void runNormalEstimation(NormalJob& job, bool all, quint64 generation) {
+        std::shared_ptr<const NormalIndex> index = job.index;
+        if (!index) {
+            // 木の構築中もキャンセルを確認し、GUIスレッドのjoinを長く待たせない
+            auto built = std::make_shared<const NormalIndex>(std::move(job.snapshot), &normalCancel);
+            if (normalCancel) return;
+            QMetaObject::invokeMethod(this, [this, generation, built]() {
+                adoptNormalIndex(generation, built);
+            }, Qt::QueuedConnection);
+            index = built;
+        }
+        const PatchedNeighborSearch search(index, std::move(job.staleIndices), std::move(job.stalePositions), job.size);
+        const unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::vector<uint32_t>> collected(threadCount); // スレッドごとに集めた近傍点
+
+        // [0, total)をブロックに分けて全スレッドで処理する。bodyは(スレッド番号, ブロックの範囲)を受け取る。
+        auto forEachBlock = [&](size_t total, const std::function<void(unsigned, size_t, size_t)>& body) {
+            const size_t numBlocks = (total + kNormalBlockSize - 1) / kNormalBlockSize;
+            std::atomic<size_t> nextBlock{0};
+            auto worker = [&](unsigned t) {
+                for (;;) {
+                    if (normalCancel) return;
+                    const size_t block = nextBlock++;
+                    if (block >= numBlocks) return;
+                    const size_t begin = block * kNormalBlockSize;
+                    body(t, begin, std::min(total, begin + kNormalBlockSize));
+                }
+            };
+            std::vector<std::thread> workers;
+            for (unsigned t = 1; t < threadCount; ++t) {
+                workers.emplace_back(worker, t);
+            }
+            worker(0);
+            for (auto& t : workers) {
+                t.join();
+            }
+        };
+
+        // indicesの点の法線を推定してGUIスレッドへ送る。collectなら広めの近傍をcollected[t]に加える。
+        // countedは進捗に数える点数 (近傍として追加した点は数えない)。
+        auto estimateBlock = [&](unsigned t, std::vector<uint32_t> blockIndices, bool collect, size_t counted) {
+            std::vector<KdTree::Neighbor> neighbors, scratch;
+            std::vector<QVector3D> neighborPositions;
+            std::vector<QVector3D> blockNormals(blockIndices.size());
+            for (size_t j = 0; j < blockIndices.size(); ++j) {
+                const QVector3D p = search.position(blockIndices[j]);
+                search.knn(p, collect ? kExpandNeighbors : kNormalNeighbors, neighbors, scratch);
+                neighborPositions.clear();
+                for (size_t m = 0; m < neighbors.size() && m < kNormalNeighbors; ++m) {
+                    neighborPositions.push_back(search.position(neighbors[m].index));
+                }
+                if (collect) {
+                    for (const auto& n : neighbors) collected[t].push_back(n.index);
+                }
+                QVector3D n;
+                if (!estimateNormalPca(neighborPositions, n)) {
+                    n = provisionalNormal(p);
+                } else if (QVector3D::dotProduct(n, -p) < 0) {
+                    n = -n; // 視点側を向くように反転
+                }
+                blockNormals[j] = n;
+            }
+            QMetaObject::invokeMethod(this, [this, generation, blockIndices, blockNormals, counted]() {
+                applyNormalBlock(generation, blockIndices, blockNormals, counted);
+            }, Qt::QueuedConnection);
+        };
+
+        const std::vector<uint32_t>& targets = job.targets;
+        const bool expand = job.expandNeighbors;
+        forEachBlock(targets.size(), [&](unsigned t, size_t begin, size_t end) {
+            estimateBlock(t, std::vector<uint32_t>(targets.begin() + begin, targets.begin() + end), expand, end - begin);
+        });
+        if (expand) {
+            // 動いた点・削除された点の元の位置の近傍は、その点を近傍に含めて推定されている
+            const std::vector<QVector3D>& seeds = job.seeds;
+            forEachBlock(seeds.size(), [&](unsigned t, size_t begin, size_t end) {
+                std::vector<KdTree::Neighbor> neighbors, scratch;
+                for (size_t j = begin; j < end; ++j) {
+                    search.knn(seeds[j], kExpandNeighbors, neighbors, scratch);
+                    for (const auto& n : neighbors) collected[t].push_back(n.index);
+                }
+            });
+            if (normalCancel) return;
+
+            std::unordered_set<uint32_t> marked(targets.begin(), targets.end());
+            std::vector<uint32_t> extra;
+            for (const auto& list : collected) {
+                for (uint32_t i : list) {
+                    if (marked.insert(i).second) extra.push_back(i);
+                }
+            }
+            forEachBlock(extra.size(), [&](unsigned t, size_t begin, size_t end) {
+                estimateBlock(t, std::vector<uint32_t>(extra.begin() + begin, extra.begin() + end), false, 0);
+            });
+        }
+        if (normalCancel) return;
+        // 全ブロックの後に届くので、ここで完了を通知する
+        QMetaObject::invokeMethod(this, [this, generation, all]() {
+            finishNormalEstimation(generation, all);
+        }, Qt::QueuedConnection);
+    }
+
+    void adoptNormalIndex(quint64 generation, const std::shared_ptr<const NormalIndex>& index) {
+        if (generation != normalGeneration) return;
+        normalIndex = index;
+    }
+
+    // GUIスレッドで推定済みブロックを反映する。古いジョブの結果と、推定中に再読み込みで
+    // 変わった点 (normalPendingに入っており、次のジョブで推定し直す) の結果は捨てる。
+    void applyNormalBlock(quint64 generation, const std::vector<uint32_t>& indices, const std::vector<QVector3D>& blockNormals,
+                          size_t targetCount) {
+        if (generation != normalGeneration) return;
+        std::vector<uint32_t> applied;
+        applied.reserve(indices.size());
+        for (size_t j = 0; j < indices.size(); ++j) {
+            const uint32_t i = indices[j];
+            if (i >= normals.size() || normalPending.count(i)) continue;
+            normals[i] = blockNormals[j];
+            applied.push_back(i);
+        }
+        normalsDone += targetCount;
+        std::sort(applied.begin(), applied.end());
+        markDirty(applied, normalDirtyRanges, normalGpuDirty, normalBufferCapacity);
+        emit normalsProgress(normalsDone, normalsTotal);
+        emit normalsUpdated();
+    }
+
+    void finishNormalEstimation(quint64 generation, bool all) {
+        if (generation != normalGeneration) return;
+        if (normalThread.joinable()) normalThread.join();
+        normalJobRunning = false;
+        emit normalsProgress(normalsTotal, normalsTotal);
+        if (!normalPending.empty() || !normalSeeds.empty()) {
+            normalCacheDirty = true;
+            startNormalEstimation(false); // 推定中に再読み込みで変わった点
+        } else if (all) {
+            saveNormalCache();
+        } else {
+            // 部分的な再推定のたびに全点を書き直さないよう、キャッシュへの保存は点群を手放すときに行う
+            normalCacheDirty = true;
+        }
+    }
+
+    // 再推定した法線が揃っていれば、キャッシュに保存する
+    void flushNormalCache() {
+        if (normalCacheDirty && !normalJobRunning && normalPending.empty() && normalSeeds.empty()) saveNormalCache();
+        normalCacheDirty = false;
+    }
+
+    // 書き込み側がファイルを削除してから作り直すと、ファイルの監視は外れたままになる。
+    // 親ディレクトリも監視しておき、ファイルが現れたらdirectoryChangedで付け直す。
+    void updateWatchedPath() {
+        const QStringList watched = fileWatcher.files() + fileWatcher.directories();
+        if (!watched.isEmpty()) {
+            fileWatcher.removePaths(watched);
+        }
+        if (!watchEnabled || sourcePath.isEmpty()) return;
+        fileWatcher.addPath(QFileInfo(sourcePath).absolutePath());
+        if (QFileInfo::exists(sourcePath)) {
+            fileWatcher.addPath(sourcePath);
+        }
+    }
+
+    // --- 法線キャッシュ (PLYと同じ場所に "<ファイル名>.normals" として保存) ---
+    // 差分再読み込み後は点の並びがファイルの順序と一致しないため、(u, v)が点ごとに一意なら
+    // (u, v)付きで保存し、読み込み時にuv_mapで対応付ける。一意でない点群は全体読み込みでしか
+    // 作られず、点の並びがファイルの順序のままなので法線だけを並べて保存する。
+    struct NormalCacheHeader {
+        char magic[4];
+        quint32 version;
+        quint64 count;
+        qint64 sourceSize;
+        qint64 sourceModified;
+        quint32 keyed; // 1なら各レコードがNormalCacheRecord
+        quint32 reserved;
+    };
+
+    struct NormalCacheRecord {
+        quint32 u, v;
+        QVector3D normal;
+    };
+
+    QString normalCachePath() const {
+        return sourcePath + ".normals";
+    }
+
+    bool hasUniqueUV() const {
+        return !points.empty() && uv_map.size() == points.size();
+    }
+
+    // 保存・照合には、保存時点ではなく点群を読み込んだ時点の元ファイルの情報を使う
+    NormalCacheHeader makeNormalCacheHeader() const {
+        NormalCacheHeader header = {{'S', '3', 'D', 'N'}, 2, points.size(), sourceStamp.size,
+                                    sourceStamp.modified, hasUniqueUV() ? 1u : 0u, 0};
+        return header;
+    }
+
+    // 元のPLYとサイズ・更新日時・点数が一致するキャッシュがあれば法線を読み込む
+    bool loadNormalCache() {
+        QFile file(normalCachePath());
+        if (!file.open(QIODevice::ReadOnly)) return false;
+        NormalCacheHeader expected = makeNormalCacheHeader();
+        NormalCacheHeader header;
+        if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+            std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+            header.version != expected.version || header.count != expected.count ||
+            header.sourceSize != expected.sourceSize || header.sourceModified != expected.sourceModified ||
+            header.keyed != expected.keyed) {
+            return false;
+        }
+        std::vector<QVector3D> cached(points.size());
+        if (header.keyed) {
+            std::vector<NormalCacheRecord> records(points.size());
+            const qint64 bytes = static_cast<qint64>(records.size() * sizeof(NormalCacheRecord));
+            if (file.read(reinterpret_cast<char*>(records.data()), bytes) != bytes) return false;
+            std::vector<char> assigned(points.size(), 0);
+            for (const NormalCacheRecord& record : records) {
+                auto it = uv_map.find({record.u, record.v});
+                if (it == uv_map.end() || assigned[it->second]) return false;
+                cached[it->second] = record.normal;
+                assigned[it->second] = 1;
+            }
+        } else {
+            const qint64 bytes = static_cast<qint64>(cached.size() * sizeof(QVector3D));
+            if (file.read(reinterpret_cast<char*>(cached.data()), bytes) != bytes) return false;
+        }
+
+        ++normalGeneration; // 実行中のジョブがあれば結果を無効にする
+        normals.swap(cached);
+        normalsDone = normalsTotal = normals.size();
+        std::cout << "Loaded cached normals from " << normalCachePath().toStdString() << std::endl;
+        emit normalsProgress(normalsDone, normals.size());
+        return true;
+    }
+
+    void saveNormalCache() {
+        if (sourceStamp.size < 0) return; // 読み込み時に元ファイルの情報が取れなかった
+        QFile file(normalCachePath());
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::cerr << "Could not write normal cache: " << normalCachePath().toStdString() << std::endl;
+            return;
+        }
+        NormalCacheHeader header = makeNormalCacheHeader();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (header.keyed) {
+            std::vector<NormalCacheRecord> records(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                records[i] = {points[i].u, points[i].v, normals[i]};
+            }
+            file.write(reinterpret_cast<const char*>(records.data()),
+                       static_cast<qint64>(records.size() * sizeof(NormalCacheRecord)));
+        } else {
+            file.write(reinterpret_cast<const char*>(normals.data()),
+                       static_cast<qint64>(normals.size() * sizeof(QVector3D)));
+        }
+    }
+
+    std::vector<Point> points;
+    std::unordered_map<std::pair<unsigned int, unsigned int>, size_t, UVHash> uv_map;
+    CloudStats stats;
+    size_t selectedIndex = npos;
+    QString sourcePath;
+    SourceStamp sourceStamp; // 点群の内容に対応する元ファイルの情報 (法線キャッシュのヘッダに使う)
+    QOpenGLBuffer vertexBuffer; // 全ビューで共有するVBO
+    bool gpuDirty = true;
+    size_t vertexBufferCapacity = 0; // VBOに確保済みの点数
+    std::vector<std::pair<size_t, size_t>> vertexDirtyRanges; // GPU未転送の範囲 (開始, 個数)
+
+    // ファイル監視 (差分再読み込み)
+    QFileSystemWatcher fileWatcher;
+    QTimer reloadTimer;
+    bool watchEnabled = false;
+    std::thread reloadThread; // パースと差分の計算を行うワーカー
+    std::atomic<bool> reloadCancel{false};
+    quint64 reloadGeneration = 0; // 全体の読み込みごとに増やし、古い再読み込みの結果を識別する
+    bool reloadQueued = false;    // 読み込み中に変更通知が来た
+
+    // 法線 (点と同じ順序)。推定中は仮法線が入っており、ブロック単位で置き換わる。
+    std::vector<QVector3D> normals;
+    QOpenGLBuffer normalBuffer; // 全ビューで共有する法線VBO
+    bool normalGpuDirty = true;
+    size_t normalBufferCapacity = 0;
+    std::vector<std::pair<size_t, size_t>> normalDirtyRanges; // GPU未転送の範囲 (開始, 個数)
+    std::unordered_set<uint32_t> normalPending; // 再読み込みで変わり、法線を推定し直す点
+    std::vector<QVector3D> normalSeeds; // 再読み込みで動いた・削除された点の元の位置 (この近傍も推定し直す)
+    std::shared_ptr<const NormalIndex> normalIndex; // ジョブをまたいで使い回す近傍探索インデックス
+    std::unordered_set<uint32_t> indexStale; // normalIndex(または構築中のもの)の構築後に位置が変わった点
+    bool normalJobRunning = false;
+    bool normalCacheDirty = false; // 再推定した法線をまだキャッシュに保存していない
+    size_t normalsDone = 0;
+    size_t normalsTotal = 0;
+    quint64 normalGeneration = 0; // ロードごとに増やし、古いジョブの結果を識別する
+    std::thread normalThread;
+    std::atomic<bool> normalCancel{false};
+};
+
+
+// 点群を描画するOpenGLウィジェット
+class PointCloudWidget : public QOpenGLWidget, protected QOpenGLFunctions
+{
+    Q_OBJECT
+
+public:
+    PointCloudWidget(PointCloudData *cloudData, QWidget *parent = nullptr) : QOpenGLWidget(parent), cloud(cloudData) {
+        connect(cloud, &PointCloudData::cloudChanged, this, [this]() { update(); });
+        connect(cloud, &PointCloudData::selectionChanged, this, &PointCloudWidget::updateHighlight);
+        connect(cloud, &PointCloudData::normalsUpdated, this, [this]() {
+            if (shadingMode == ShadingMode::Lit) update();
+        });
+    }
+
+    // 点の描画方法
+    enum class ShadingMode {
+        Flat, // 頂点色のみ
+        Lit   // 推定法線によるライティング付き点スプラット
+    };
+
+    void setInitialCameraState(const QVector3D& pos, const QVector3D& center, const QVector3D& up) {
+        initialCameraPosition = pos;
+        initialViewCenter = center;
+        initialUpVector = up;
+    }
+
+    QVector3D getCameraPosition() const { return cameraPosition; }
+    QVector3D getViewCenter() const { return viewCenter; }
+    QVector3D getUpVector() const { return upVector; }
+
+    void setAutoFraming(bool enabled) {
+        autoFraming = enabled;
+    }
+
+    void setShadingMode(ShadingMode mode) {
+        shadingMode = mode;
+        update();
+    }
+
+public slots:
+    // 他のビューからカメラ状態を受け取る (カメラ連動用)
+    void setCameraState(const QVector3D& pos, const QVector3D& center, const QVector3D& up) {
+        cameraPosition = pos;
+        viewCenter = center;
+        upVector = up;
         requestUpdate();
     }
+
+    // 共有点群の選択点から、このビューのハイライト線を更新する
+    void updateHighlight() {
+        const Point* selected = cloud ? cloud->selectedPoint() : nullptr;
+        if (selected) {
+            lineTargetPoint = QVector3D(selected->x, selected->y, selected->z);
+            lineStartPoint = initialCameraPosition; // 原点
+            lineDistance = lineStartPoint.distanceToPoint(lineTargetPoint);
+            isLineActive = true;
+        } else {
+            isLineActive = false;
+        }
+        emit lineDistanceCalculated(isLineActive ? lineDistance : -1.0f);
+        update();
+    }
+
     void resetView() {
+        // 自動フレーミング: 初期視点の向きとUpを保ったまま、点群全体が収まる位置に置く
+        if (autoFraming && frameCloud(initialViewCenter - initialCameraPosition, initialUpVector)) {
+            requestUpdate();
+            return;
+        }
         cameraPosition = initialCameraPosition;
         viewCenter = initialViewCenter;
         upVector = initialUpVector;
         requestUpdate();
     }
     void setFrontView() {
+        if (autoFraming && frameCloud(QVector3D(0, 0, 1), QVector3D(0, -1, 0))) {
+            requestUpdate();
+            return;
+        }
         cameraPosition = QVector3D(0, 0, 0);
         viewCenter = QVector3D(0, 1, 100);
         upVector = QVector3D(0, -1, 0);
@@ -413,10 +1762,14 @@ signals:
 protected:
     void initializeGL() override {
         initializeOpenGLFunctions();
+        // コンテキスト破棄時に共有VBOを解放する
+        connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, &PointCloudWidget::cleanupGL, Qt::UniqueConnection);
         glClearColor(0.1f, 0.1f, 0.2f, 1.0f);
         glEnable(GL_DEPTH_TEST);
         glPointSize(2.0f);
-        resetView(); // 初期視点に設定
+        if (upVector.isNull()) {
+            resetView(); // 初期視点に設定 (カメラ連動で既に設定済みの場合を除く)
+        }
     }
 
     void resizeGL(int w, int h) override {
@@ -427,20 +1780,20 @@ protected:
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glMatrixMode(GL_PROJECTION);
         glLoadIdentity();
+        float nearPlane = 0.1f, farPlane = 10000.0f;
+        computeClipPlanes(nearPlane, farPlane);
         QMatrix4x4 projection;
-        projection.perspective(45.0f, float(width()) / float(height()), 0.1f, 10000.0f);
+        projection.perspective(kFieldOfView, float(width()) / float(height()), nearPlane, farPlane);
         glLoadMatrixf(projection.constData());
         glMatrixMode(GL_MODELVIEW);
         glLoadIdentity();
+        // ヘッドライト: 視点座標系で設定し、常にカメラ方向から照らす
+        const GLfloat lightDirection[4] = {0.0f, 0.0f, 1.0f, 0.0f};
+        glLightfv(GL_LIGHT0, GL_POSITION, lightDirection);
         QMatrix4x4 view;
         view.lookAt(cameraPosition, viewCenter, upVector);
         glLoadMatrixf(view.constData());
-        glBegin(GL_POINTS);
-        for (const auto& p : points) {
-            glColor3ub(p.r, p.g, p.b);
-            glVertex3f(p.x, p.y, p.z);
-        }
-        glEnd();
+        drawPoints();
 
         if (isLineActive) {
             drawHighlightLine();
@@ -471,12 +1824,14 @@ protected:
     }
 
     void wheelEvent(QWheelEvent *event) override {
+        // 最小ステップと最小距離は点群の大きさに合わせる
+        const float minDistance = 0.01f * sceneScale();
         float zoomFactor = 0.1f * cameraPosition.distanceToPoint(viewCenter);
-        zoomFactor = std::max(1.0f, zoomFactor);
+        zoomFactor = std::max(minDistance, zoomFactor);
         float zoomAmount = event->angleDelta().y() / 120.0f * zoomFactor;
         QVector3D viewDirection = (cameraPosition - viewCenter).normalized();
         float distance = cameraPosition.distanceToPoint(viewCenter);
-        if (distance - zoomAmount > 1.0f) {
+        if (distance - zoomAmount > minDistance) {
             cameraPosition -= viewDirection * zoomAmount;
         }
         requestUpdate();
@@ -490,7 +1845,7 @@ protected:
         int dx = event->pos().x() - lastPos.x();
         int dy = event->pos().y() - lastPos.y();
         if (event->buttons() & Qt::RightButton) {
-            float panSpeed = 0.002f * cameraPosition.distanceToPoint(viewCenter);
+            float panSpeed = panSpeedPerPixel();
             QVector3D viewDirection = (viewCenter - cameraPosition).normalized();
             QVector3D rightDirection = QVector3D::crossProduct(viewDirection, upVector).normalized();
             QVector3D actualUpDirection = QVector3D::crossProduct(rightDirection, viewDirection).normalized();
@@ -507,7 +1862,7 @@ protected:
             rotationMatrix.rotate(-dy * rotationSpeed, rightDirection);
             cameraPosition = viewCenter + rotationMatrix.map(cameraPosition - viewCenter);
         } else if (event->buttons() & Qt::MiddleButton) {
-            float panSpeed = 0.002f * cameraPosition.distanceToPoint(viewCenter);
+            float panSpeed = panSpeedPerPixel();
             QVector3D viewDirection = (viewCenter - cameraPosition).normalized();
             QVector3D rightDirection = QVector3D::crossProduct(viewDirection, upVector).normalized();
             QVector3D actualUpDirection = QVector3D::crossProduct(rightDirection, viewDirection).normalized();
@@ -518,7 +1873,107 @@ protected:
         requestUpdate();
     }
 
+private slots:
+    void cleanupGL() {
+        if (!cloud) return;
+        makeCurrent();
+        cloud->destroyGpuResources();
+        doneCurrent();
+    }
+
 private:
+    static constexpr float kFieldOfView = 45.0f; // 垂直画角 [度]
+
+    // 点群の大きさ (統計の包含球半径)。点群がなければ従来の固定値と同じ操作感になる値を返す。
+    float sceneScale() const {
+        const CloudStats* stats = cloud ? &cloud->getStats() : nullptr;
+        return stats && stats->isValid() ? std::max(stats->boundingRadius(), 1e-3f) : 100.0f;
+    }
+
+    // ドラッグ1ピクセルあたりの平行移動量。注視点に近づきすぎても止まらないよう、
+    // 統計があるときだけ点群の大きさに応じた下限を設ける。
+    float panSpeedPerPixel() const {
+        float distance = cameraPosition.distanceToPoint(viewCenter);
+        if (cloud && cloud->getStats().isValid()) distance = std::max(distance, 0.01f * sceneScale());
+        return 0.002f * distance;
+    }
+
+    // 視線方向directionとupを保ち、重心を注視点として点群全体が画角に収まる位置へカメラを置く
+    bool frameCloud(QVector3D direction, const QVector3D& up) {
+        if (!cloud || !cloud->getStats().isValid()) return false;
+        const CloudStats& stats = cloud->getStats();
+        if (direction.isNull()) direction = QVector3D(0, 0, 1);
+        direction.normalize();
+
+        // 幅が高さより狭い場合は水平画角で決める
+        const float aspect = height() > 0 ? float(width()) / float(height()) : 1.0f;
+        const float halfFov = std::atan(std::tan(qDegreesToRadians(kFieldOfView) / 2.0f) * std::min(1.0f, aspect));
+        const float radius = std::max(stats.boundingRadius(), 1e-3f);
+        const float distance = radius / std::sin(halfFov);
+
+        viewCenter = stats.centroid();
+        cameraPosition = viewCenter - direction * distance;
+        upVector = up;
+        return true;
+    }
+
+    // 点群(とハイライト線)の包含球からニア/ファー面を決める。点群がなければ既定値のまま。
+    void computeClipPlanes(float& nearPlane, float& farPlane) const {
+        if (!cloud || !cloud->getStats().isValid()) return;
+        const CloudStats& stats = cloud->getStats();
+        const QVector3D center = stats.centroid();
+        float radius = std::max(stats.boundingRadius(), 1e-3f);
+        if (isLineActive) {
+            radius = std::max(radius, center.distanceToPoint(lineStartPoint));
+        }
+        const float distance = cameraPosition.distanceToPoint(center);
+        farPlane = (distance + radius) * 1.05f;
+        // 深度精度を保つため、ニア面はファー面の1/10000より手前にしない
+        nearPlane = std::max((distance - radius) * 0.95f, farPlane * 1e-4f);
+    }
+
+    // 共有VBOから点群を描画する。陰影モードでは法線VBOを使い、ライティングした点スプラットとして描く。
+    void drawPoints() {
+        if (!cloud || !cloud->bindVertexBuffer()) return;
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(3, GL_FLOAT, sizeof(Point), reinterpret_cast<const void*>(offsetof(Point, x)));
+        glColorPointer(3, GL_UNSIGNED_BYTE, sizeof(Point), reinterpret_cast<const void*>(offsetof(Point, r)));
+
+        const bool lit = shadingMode == ShadingMode::Lit && cloud->bindNormalBuffer();
+        if (lit) {
+            glEnableClientState(GL_NORMAL_ARRAY);
+            glNormalPointer(GL_FLOAT, sizeof(QVector3D), nullptr);
+            const GLfloat ambient[4] = {0.35f, 0.35f, 0.35f, 1.0f};
+            glLightModelfv(GL_LIGHT_MODEL_AMBIENT, ambient);
+            glEnable(GL_LIGHTING);
+            glEnable(GL_LIGHT0);
+            glEnable(GL_COLOR_MATERIAL);
+            glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+            // 丸い点スプラット
+            glEnable(GL_POINT_SMOOTH);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glPointSize(splatSize);
+        }
+
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(cloud->size()));
+
+        if (lit) {
+            glPointSize(2.0f);
+            glDisable(GL_BLEND);
+            glDisable(GL_POINT_SMOOTH);
+            glDisable(GL_COLOR_MATERIAL);
+            glDisable(GL_LIGHT0);
+            glDisable(GL_LIGHTING);
+            glDisableClientState(GL_NORMAL_ARRAY);
+            cloud->releaseNormalBuffer();
+        }
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        cloud->releaseVertexBuffer();
+    }
+
     void drawHighlightLine() {
         glColor3f(1.0f, 1.0f, 0.0f); // Yellow
         glLineWidth(3.0f);
@@ -537,8 +1992,10 @@ private:
         emit cameraChanged(cameraPosition, viewCenter, upVector);
     }
 
-    std::vector<Point> points;
-    std::map<std::pair<unsigned int, unsigned int>, size_t> uv_map;
+    QPointer<PointCloudData> cloud; // 共有点群 (MainWindowが所有)
+    ShadingMode shadingMode = ShadingMode::Flat;
+    float splatSize = 4.0f;
+    bool autoFraming = true; // 統計情報から視点を自動で決める
     bool isLineActive = false;
     QVector3D lineStartPoint;
     QVector3D lineTargetPoint;
@@ -564,6 +2021,9 @@ public:
         initialViewCenter = QVector3D(1, 1, 1);
         initialUpVector = QVector3D(0, -1, 0);
 
+        // 全ビューで共有する点群データ
+        cloudData = new PointCloudData(this);
+
         // --- UIのセットアップ ---
         setupMenuBar();
         QWidget *centralWidget = new QWidget;
@@ -584,39 +2044,100 @@ public:
         imageLabel->setAlignment(Qt::AlignCenter);
         splitter->addWidget(imageLabel);
 
-        // --- 点群ビューアとコントロールパネルのコンテナ ---
+        // --- 点群ビューを並べるスプリッタ ---
+        viewSplitter = new QSplitter;
+        splitter->addWidget(viewSplitter);
+        addPointCloudView();
+
+        splitter->setSizes({400, 600});
+
+        connect(loadImageButton, &QPushButton::clicked, this, &MainWindow::loadImage);
+        connect(loadPlyButton, &QPushButton::clicked, this, &MainWindow::loadPointCloud);
+        connect(resetViewButton, &QPushButton::clicked, this, &MainWindow::resetAllViews);
+
+        // --- シグナル/スロット接続 ---
+        connect(imageLabel, &ImageLabel::clickedPixel, cloudData, &PointCloudData::selectPixel);
+        connect(cloudData, &PointCloudData::normalsProgress, this, &MainWindow::updateNormalStatus);
+        connect(cloudData, &PointCloudData::cloudReloaded, this, &MainWindow::showReloadStatus);
+        connect(cloudData, &PointCloudData::cloudChanged, this, &MainWindow::updateStatsLabel);
+
+        // 点群の範囲を常に表示するラベル
+        statsLabel = new QLabel;
+        statusBar()->addPermanentWidget(statsLabel);
+
+        resize(1000, 650);
+        updateWindowTitle(initialCameraPosition, initialViewCenter, initialUpVector); // 初回タイトル設定
+    }
+
+private:
+    void setupMenuBar() {
+        QMenu *fileMenu = menuBar()->addMenu(QString::fromUtf8("ファイル"));
+        QAction *watchAction = new QAction(QString::fromUtf8("変更を監視して自動で再読み込み"), this);
+        watchAction->setCheckable(true);
+        connect(watchAction, &QAction::toggled, cloudData, &PointCloudData::setWatchEnabled);
+        fileMenu->addAction(watchAction);
+        fileMenu->addSeparator();
+        QAction *exitAction = new QAction(QString::fromUtf8("終了"), this);
+        connect(exitAction, &QAction::triggered, qApp, &QApplication::quit);
+        fileMenu->addAction(exitAction);
+
+        QMenu *viewMenu = menuBar()->addMenu(QString::fromUtf8("表示"));
+        QAction *addViewAction = new QAction(QString::fromUtf8("ビューを追加"), this);
+        connect(addViewAction, &QAction::triggered, this, &MainWindow::addPointCloudView);
+        viewMenu->addAction(addViewAction);
+        QAction *linkCamerasAction = new QAction(QString::fromUtf8("カメラを連動"), this);
+        linkCamerasAction->setCheckable(true);
+        connect(linkCamerasAction, &QAction::toggled, this, &MainWindow::setCamerasLinked);
+        viewMenu->addAction(linkCamerasAction);
+        QAction *litShadingAction = new QAction(QString::fromUtf8("法線で陰影表示"), this);
+        litShadingAction->setCheckable(true);
+        connect(litShadingAction, &QAction::toggled, this, &MainWindow::setLitShading);
+        viewMenu->addAction(litShadingAction);
+
+        QMenu *settingsMenu = menuBar()->addMenu(QString::fromUtf8("設定"));
+        QAction *configAction = new QAction(QString::fromUtf8("初期視点を設定..."), this);
+        connect(configAction, &QAction::triggered, this, &MainWindow::openConfigDialog);
+        settingsMenu->addAction(configAction);
+        QAction *autoFramingAction = new QAction(QString::fromUtf8("点群に合わせて視点を自動調整"), this);
+        autoFramingAction->setCheckable(true);
+        autoFramingAction->setChecked(autoFraming);
+        connect(autoFramingAction, &QAction::toggled, this, &MainWindow::setAutoFraming);
+        settingsMenu->addAction(autoFramingAction);
+    }
+
+    // オーバーレイ表示用ラベルを作成する
+    QLabel* createOverlayLabel(Qt::Alignment alignment) {
+        QLabel *label = new QLabel;
+        label->setStyleSheet("background-color: rgba(0, 0, 0, 150); color: white; padding: 5px; border-radius: 3px;");
+        label->setAlignment(alignment);
+        return label;
+    }
+
+private slots:
+    // 共有点群を参照する点群ビューとコントロールパネルのコンテナを追加する
+    void addPointCloudView() {
         QWidget *pointCloudContainer = new QWidget;
         QGridLayout *pointCloudLayout = new QGridLayout(pointCloudContainer);
         pointCloudLayout->setContentsMargins(0,0,0,0);
-        pointCloudWidget = new PointCloudWidget;
+        PointCloudWidget *pointCloudWidget = new PointCloudWidget(cloudData);
         pointCloudWidget->setInitialCameraState(initialCameraPosition, initialViewCenter, initialUpVector);
+        pointCloudWidget->setShadingMode(shadingMode);
+        pointCloudWidget->setAutoFraming(autoFraming);
         ViewControlPanel *viewPanel = new ViewControlPanel;
 
         // カメラ情報表示ラベル
-        cameraInfoLabel = new QLabel;
-        cameraInfoLabel->setStyleSheet("background-color: rgba(0, 0, 0, 150); color: white; padding: 5px; border-radius: 3px;");
-        cameraInfoLabel->setAlignment(Qt::AlignRight);
+        QLabel *cameraInfoLabel = createOverlayLabel(Qt::AlignRight);
 
         // 距離情報表示ラベル
-        lineDistanceLabel = new QLabel;
-        lineDistanceLabel->setStyleSheet("background-color: rgba(0, 0, 0, 150); color: white; padding: 5px; border-radius: 3px;");
-        lineDistanceLabel->setAlignment(Qt::AlignLeft);
+        QLabel *lineDistanceLabel = createOverlayLabel(Qt::AlignLeft);
         lineDistanceLabel->hide(); // 最初は非表示
 
         pointCloudLayout->addWidget(pointCloudWidget, 0, 0);
         pointCloudLayout->addWidget(viewPanel, 0, 0, Qt::AlignTop | Qt::AlignRight);
         pointCloudLayout->addWidget(cameraInfoLabel, 0, 0, Qt::AlignBottom | Qt::AlignRight); // 右下に配置
         pointCloudLayout->addWidget(lineDistanceLabel, 0, 0, Qt::AlignBottom | Qt::AlignLeft); // 左下に配置
-        splitter->addWidget(pointCloudContainer);
-
-        splitter->setSizes({400, 600});
-
-        connect(loadImageButton, &QPushButton::clicked, this, &MainWindow::loadImage);
-        connect(loadPlyButton, &QPushButton::clicked, this, &MainWindow::loadPointCloud);
-        connect(resetViewButton, &QPushButton::clicked, pointCloudWidget, &PointCloudWidget::resetView);
+        viewSplitter->addWidget(pointCloudContainer);
 
-        // --- シグナル/スロット接続 ---
-        connect(imageLabel, &ImageLabel::clickedPixel, pointCloudWidget, &PointCloudWidget::findAndHighlightPoint);
         connect(viewPanel, &ViewControlPanel::frontViewRequested, pointCloudWidget, &PointCloudWidget::setFrontView);
         connect(viewPanel, &ViewControlPanel::rightViewRequested, pointCloudWidget, &PointCloudWidget::setRightView);
         connect(viewPanel, &ViewControlPanel::topViewRequested, pointCloudWidget, &PointCloudWidget::setTopView);
@@ -624,38 +2145,114 @@ public:
         connect(viewPanel, &ViewControlPanel::pitchRequested, pointCloudWidget, &PointCloudWidget::rotatePitch);
         connect(viewPanel, &ViewControlPanel::rollRequested, pointCloudWidget, &PointCloudWidget::rotateRoll);
 
-        // カメラ位置が変更されたらウィンドウタイトルと情報ラベルを更新
+        // カメラ位置が変更されたらウィンドウタイトルと情報ラベルを更新し、連動中なら他のビューへ伝える
         connect(pointCloudWidget, &PointCloudWidget::cameraChanged, this, &MainWindow::updateWindowTitle);
-        connect(pointCloudWidget, &PointCloudWidget::cameraChanged, this, &MainWindow::updateCameraInfoLabel);
-        connect(pointCloudWidget, &PointCloudWidget::lineDistanceCalculated, this, &MainWindow::updateLineDistanceLabel);
+        connect(pointCloudWidget, &PointCloudWidget::cameraChanged, cameraInfoLabel,
+                [this, cameraInfoLabel](const QVector3D& pos, const QVector3D& center, const QVector3D& up) {
+                    updateCameraInfoLabel(cameraInfoLabel, pos, center, up);
+                });
+        connect(pointCloudWidget, &PointCloudWidget::cameraChanged, this,
+                [this, pointCloudWidget](const QVector3D& pos, const QVector3D& center, const QVector3D& up) {
+                    syncLinkedCameras(pointCloudWidget, pos, center, up);
+                });
+        connect(pointCloudWidget, &PointCloudWidget::lineDistanceCalculated, lineDistanceLabel,
+                [this, lineDistanceLabel](float distance) {
+                    updateLineDistanceLabel(lineDistanceLabel, distance);
+                });
+
+        updateCameraInfoLabel(cameraInfoLabel, initialCameraPosition, initialViewCenter, initialUpVector); // 初回ラベル設定
+        pointCloudWidget->updateHighlight(); // 既に選択中の点があれば反映
+        if (camerasLinked && !pointCloudViews.isEmpty()) {
+            PointCloudWidget *source = pointCloudViews.first();
+            pointCloudWidget->setCameraState(source->getCameraPosition(), source->getViewCenter(), source->getUpVector());
+        }
+        pointCloudViews.append(pointCloudWidget);
+    }
 
-        resize(1000, 650);
-        updateWindowTitle(initialCameraPosition, initialViewCenter, initialUpVector); // 初回タイトル設定
-        updateCameraInfoLabel(initialCameraPosition, initialViewCenter, initialUpVector); // 初回ラベル設定
+    void setCamerasLinked(bool linked) {
+        camerasLinked = linked;
+        // 連動開始時は先頭のビューに揃える
+        if (linked && !pointCloudViews.isEmpty()) {
+            PointCloudWidget *source = pointCloudViews.first();
+            syncLinkedCameras(source, source->getCameraPosition(), source->getViewCenter(), source->getUpVector());
+        }
     }
 
-private:
-    void setupMenuBar() {
-        QMenu *fileMenu = menuBar()->addMenu(QString::fromUtf8("ファイル"));
-        QAction *exitAction = new QAction(QString::fromUtf8("終了"), this);
-        connect(exitAction, &QAction::triggered, qApp, &QApplication::quit);
-        fileMenu->addAction(exitAction);
+    void syncLinkedCameras(PointCloudWidget *source, const QVector3D& pos, const QVector3D& center, const QVector3D& up) {
+        if (!camerasLinked || syncingCameras) return;
+        syncingCameras = true; // 他ビューからのcameraChangedによる再帰を防ぐ
+        for (PointCloudWidget *view : pointCloudViews) {
+            if (view != source) {
+                view->setCameraState(pos, center, up);
+            }
+        }
+        syncingCameras = false;
+    }
 
-        QMenu *settingsMenu = menuBar()->addMenu(QString::fromUtf8("設定"));
-        QAction *configAction = new QAction(QString::fromUtf8("初期視点を設定..."), this);
-        connect(configAction, &QAction::triggered, this, &MainWindow::openConfigDialog);
-        settingsMenu->addAction(configAction);
+    void setLitShading(bool lit) {
+        shadingMode = lit ? PointCloudWidget::ShadingMode::Lit : PointCloudWidget::ShadingMode::Flat;
+        for (PointCloudWidget *view : pointCloudViews) {
+            view->setShadingMode(shadingMode);
+        }
+    }
+
+    void updateNormalStatus(size_t done, size_t total) {
+        if (done < total) {
+            statusBar()->showMessage(QString::fromUtf8("法線を推定中: %1 / %2").arg(done).arg(total));
+        } else {
+            statusBar()->showMessage(QString::fromUtf8("法線の推定が完了しました (%1 点)").arg(total), 5000);
+        }
+    }
+
+    void showReloadStatus(size_t modified, size_t added, size_t removed) {
+        statusBar()->showMessage(QString::fromUtf8("再読み込み: 変更 %1 点 / 追加 %2 点 / 削除 %3 点")
+                                     .arg(modified).arg(added).arg(removed), 5000);
+    }
+
+    void setAutoFraming(bool enabled) {
+        autoFraming = enabled;
+        for (PointCloudWidget *view : pointCloudViews) {
+            view->setAutoFraming(enabled);
+        }
+    }
+
+    void updateStatsLabel() {
+        const CloudStats& stats = cloudData->getStats();
+        if (!stats.isValid()) {
+            statsLabel->clear();
+            return;
+        }
+        const QVector3D minP = stats.minPoint();
+        const QVector3D maxP = stats.maxPoint();
+        const QVector3D c = stats.centroid();
+        statsLabel->setText(QString::fromUtf8("%1 点 | X [%2, %3] Y [%4, %5] Z [%6, %7] | 重心 (%8, %9, %10) | 奥行き中央値 %11 m | RGB [%12-%13, %14-%15, %16-%17]")
+            .arg(stats.count)
+            .arg(minP.x(), 0, 'f', 2).arg(maxP.x(), 0, 'f', 2)
+            .arg(minP.y(), 0, 'f', 2).arg(maxP.y(), 0, 'f', 2)
+            .arg(minP.z(), 0, 'f', 2).arg(maxP.z(), 0, 'f', 2)
+            .arg(c.x(), 0, 'f', 2).arg(c.y(), 0, 'f', 2).arg(c.z(), 0, 'f', 2)
+            .arg(stats.depthPercentile(0.5), 0, 'f', 2)
+            .arg(int(stats.minColor[0])).arg(int(stats.maxColor[0]))
+            .arg(int(stats.minColor[1])).arg(int(stats.maxColor[1]))
+            .arg(int(stats.minColor[2])).arg(int(stats.maxColor[2])));
+    }
+
+    void resetAllViews() {
+        for (PointCloudWidget *view : pointCloudViews) {
+            view->resetView();
+        }
     }
 
-private slots:
     void openConfigDialog() {
         ConfigDialog dialog(initialCameraPosition, initialViewCenter, initialUpVector, this);
         if (dialog.exec() == QDialog::Accepted) {
             initialCameraPosition = dialog.getCameraPosition();
             initialViewCenter = dialog.getViewCenter();
             initialUpVector = dialog.getUpVector();
-            pointCloudWidget->setInitialCameraState(initialCameraPosition, initialViewCenter, initialUpVector);
-            pointCloudWidget->resetView(); // 設定を即時反映
+            for (PointCloudWidget *view : pointCloudViews) {
+                view->setInitialCameraState(initialCameraPosition, initialViewCenter, initialUpVector);
+                view->resetView(); // 設定を即時反映
+            }
         }
     }
 
@@ -674,7 +2271,9 @@ private slots:
     void loadPointCloud() {
         QString filePath = QFileDialog::getOpenFileName(this, QString::fromUtf8("PLYファイルを開く"), QDir::homePath(), QString::fromUtf8("PLYファイル (*.ply)"));
         if (!filePath.isEmpty()) {
-            pointCloudWidget->loadPly(filePath.toStdString());
+            if (cloudData->loadPly(filePath.toStdString()) && autoFraming) {
+                resetAllViews(); // 読み込んだ点群が収まるように視点を合わせる
+            }
         }
     }
 
@@ -692,7 +2291,7 @@ private slots:
         setWindowTitle(title);
     }
 
-    void updateCameraInfoLabel(const QVector3D& pos, const QVector3D& center, const QVector3D& up) {
+    void updateCameraInfoLabel(QLabel *cameraInfoLabel, const QVector3D& pos, const QVector3D& center, const QVector3D& up) {
         QString text = QString::fromUtf8("位置: (%1, %2, %3)\n注視点: (%4, %5, %6)\nUp: (%7, %8, %9)")
             .arg(pos.x(), 0, 'f', 1)
             .arg(pos.y(), 0, 'f', 1)
@@ -706,7 +2305,7 @@ private slots:
         cameraInfoLabel->setText(text);
     }
 
-    void updateLineDistanceLabel(float distance) {
+    void updateLineDistanceLabel(QLabel *lineDistanceLabel, float distance) {
         if (distance >= 0) {
             lineDistanceLabel->setText(QString::fromUtf8("選択距離: %1 m").arg(distance, 0, 'f', 2));
             lineDistanceLabel->show();
@@ -717,9 +2316,14 @@ private slots:
 
 private:
     ImageLabel *imageLabel;
-    PointCloudWidget *pointCloudWidget;
-    QLabel *cameraInfoLabel; // 情報表示用ラベル
-    QLabel *lineDistanceLabel; // 距離表示用ラベル
+    PointCloudData *cloudData; // 全ビューで共有する点群
+    QSplitter *viewSplitter; // 点群ビューを並べるスプリッタ
+    QList<PointCloudWidget*> pointCloudViews;
+    QLabel *statsLabel; // 点群の統計情報表示用ラベル
+    bool camerasLinked = false;
+    bool syncingCameras = false;
+    bool autoFraming = true;
+    PointCloudWidget::ShadingMode shadingMode = PointCloudWidget::ShadingMode::Flat;
     QVector3D initialCameraPosition;
     QVector3D initialViewCenter;
     QVector3D initialUpVector;
@@ -729,6 +2333,8 @@ private:
 
 int main(int argc, char *argv[])
 {
+    // 全てのQOpenGLWidgetを同じコンテキストグループに入れ、VBOをビュー間で共有する
+    QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
     QApplication app(argc, argv);
     MainWindow window;
     window.show();